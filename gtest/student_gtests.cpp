@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "ladder.h"
 #include "dijkstras.h"
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <thread>
 
 
 // Word Ladder Test Fixture
@@ -72,3 +76,253 @@ TEST_F(DijkstrasTest, SingleVertexGraph) {
 }
 
 
+// Dawg membership must agree with the word list it was built from
+TEST_F(WordLadderTest, DawgMembership) {
+    Dawg dawg(word_list);
+    EXPECT_EQ(dawg.size(), word_list.size());
+    EXPECT_TRUE(dawg.contains("cat"));
+    EXPECT_TRUE(dawg.contains("sleep"));
+    EXPECT_FALSE(dawg.contains("ca"));
+    EXPECT_FALSE(dawg.contains("zzzzz"));
+
+    size_t three_letter = 0;
+    for (const string& word : word_list)
+        three_letter += word.size() == 3;
+    vector<string> words = dawg.words_of_length(3);
+    EXPECT_EQ(words.size(), three_letter);
+    EXPECT_TRUE(is_sorted(words.begin(), words.end()));
+
+    // Word numbers are a bijection onto 0..size()-1
+    for (uint32_t i = 0; i < dawg.size(); i += 97)
+        EXPECT_EQ(dawg.index_of(dawg.word_at(i)), i);
+    EXPECT_EQ(dawg.index_of("zzzzz"), Dawg::NO_WORD);
+}
+
+// The automaton walk finds exactly the words is_adjacent accepts
+TEST_F(WordLadderTest, DawgNeighborsMatchAdjacency) {
+    Dawg dawg(word_list);
+    for (const string word : {"cat", "sleep", "aa", "code", "x"}) {
+        vector<string> expected;
+        for (const string& candidate : word_list) {
+            if (candidate != word && is_adjacent(word, candidate))
+                expected.push_back(candidate);
+        }
+        EXPECT_EQ(dawg.neighbors(word), expected) << "neighbors of " << word;
+    }
+}
+
+// A ladder over the Dawg is as short as the one over the set
+TEST_F(WordLadderTest, DawgWordLadders) {
+    Dawg dawg(word_list);
+    EXPECT_TRUE(generate_word_ladder("were", "were", dawg).empty());
+    EXPECT_EQ(generate_word_ladder("cat", "dog", dawg).size(), 4);
+    EXPECT_EQ(generate_word_ladder("code", "data", dawg).size(), 6);
+    EXPECT_EQ(generate_word_ladder("car", "cheat", dawg).size(), 4);
+
+    vector<string> ladder = generate_word_ladder("work", "play", dawg);
+    ASSERT_EQ(ladder.size(), 6);
+    for (size_t i = 1; i < ladder.size(); ++i)
+        EXPECT_TRUE(is_adjacent(ladder[i - 1], ladder[i]));
+}
+
+// Updates publish new versions and leave earlier snapshots untouched
+TEST_F(WordLadderTest, LiveDictionaryUpdates) {
+    LiveDictionary live;
+    for (const string word : {"cat", "cot", "dot"})
+        EXPECT_TRUE(live.insert(word));
+    EXPECT_FALSE(live.insert("cat"));
+
+    shared_ptr<const LiveDictionary::Snapshot> before = live.snapshot();
+    EXPECT_TRUE(live.insert("dog"));
+    EXPECT_TRUE(live.erase("cot"));
+    EXPECT_FALSE(live.erase("cot"));
+    shared_ptr<const LiveDictionary::Snapshot> after = live.snapshot();
+
+    EXPECT_TRUE(before->contains("cot"));
+    EXPECT_FALSE(before->contains("dog"));
+    EXPECT_EQ(before->neighbors("cat"), vector<string>({"cot"}));
+    EXPECT_FALSE(after->contains("cot"));
+    EXPECT_TRUE(after->neighbors("cat").empty());
+    EXPECT_EQ(after->neighbors("dot"), vector<string>({"dog"}));
+    EXPECT_GT(after->version(), before->version());
+
+    EXPECT_TRUE(generate_word_ladder("cat", "dog", *before).empty());
+    EXPECT_TRUE(live.insert("cot"));
+    EXPECT_EQ(generate_word_ladder("cat", "dog", *live.snapshot()).size(), 4);
+
+    // Updates are case-insensitive, like the ladder queries
+    EXPECT_FALSE(live.insert("CAT"));
+    EXPECT_TRUE(live.insert("Cog"));
+    EXPECT_TRUE(live.snapshot()->contains("cog"));
+    EXPECT_TRUE(live.erase("COG"));
+    EXPECT_FALSE(live.snapshot()->contains("cog"));
+}
+
+// Keys whose full hashes collide share a leaf chain and stay separable
+TEST(PersistentMapTest, HashCollisions) {
+    struct CoarseHash {
+        size_t operator()(int key) const { return key % 3; }
+    };
+    vector<pair<int, int>> entries;
+    for (int key = 0; key < 12; ++key)
+        entries.emplace_back(key, 10 * key);
+    PersistentMap<int, int, CoarseHash> bulk(entries);
+    PersistentMap<int, int, CoarseHash> grown;
+    for (const auto& [key, value] : entries)
+        grown = grown.insert(key, value);
+
+    PersistentMap<int, int, CoarseHash> shrunk = grown.erase(4).erase(5).insert(7, 70);
+    for (int key = 0; key < 12; ++key) {
+        ASSERT_NE(bulk.find(key), nullptr);
+        EXPECT_EQ(*bulk.find(key), 10 * key);
+        ASSERT_NE(grown.find(key), nullptr);
+        EXPECT_EQ(*grown.find(key), 10 * key);
+    }
+    EXPECT_EQ(shrunk.size(), 10);
+    EXPECT_EQ(shrunk.find(4), nullptr);
+    EXPECT_EQ(shrunk.find(5), nullptr);
+    EXPECT_EQ(*shrunk.find(7), 70);
+    EXPECT_EQ(*shrunk.find(1), 10);
+    EXPECT_EQ(grown.erase(99).size(), 12);
+}
+
+// The incremental index finds the same neighbors as the Dawg
+TEST_F(WordLadderTest, LiveDictionaryNeighborsMatchDawg) {
+    set<string> short_words;
+    for (const string& word : word_list) {
+        if (word.size() <= 5)
+            short_words.insert(word);
+    }
+    Dawg dawg(short_words);
+    LiveDictionary live(short_words);
+    shared_ptr<const LiveDictionary::Snapshot> snapshot = live.snapshot();
+    EXPECT_EQ(snapshot->size(), short_words.size());
+    for (const string word : {"cat", "sleep", "aa", "code", "x", "seed"})
+        EXPECT_EQ(snapshot->neighbors(word), dawg.neighbors(word)) << "neighbors of " << word;
+    EXPECT_EQ(generate_word_ladder("code", "data", *snapshot).size(), 6);
+}
+
+// Queries on a snapshot are unaffected by a writer running alongside them
+TEST_F(WordLadderTest, LiveDictionaryConcurrentReaders) {
+    LiveDictionary live;
+    for (const string word : {"cat", "cot", "dot", "dog"})
+        live.insert(word);
+
+    thread writer([&] {
+        for (int i = 0; i < 200; ++i) {
+            live.erase("cot");
+            live.insert("cot");
+        }
+    });
+    for (int i = 0; i < 200; ++i) {
+        shared_ptr<const LiveDictionary::Snapshot> snapshot = live.snapshot();
+        size_t expected = snapshot->contains("cot") ? 4 : 0;
+        EXPECT_EQ(generate_word_ladder("cat", "dog", *snapshot).size(), expected);
+    }
+    writer.join();
+    EXPECT_TRUE(live.snapshot()->contains("cot"));
+}
+
+// A stats pointer reports how much of the graph a query expanded
+TEST_F(WordLadderTest, LadderStatsCountExpandedNodes) {
+    Dawg dawg(word_list);
+    LadderStats near, far;
+    EXPECT_EQ(generate_word_ladder("cat", "cot", dawg, &near).size(), 2);
+    EXPECT_EQ(generate_word_ladder("cat", "dog", dawg, &far).size(), 4);
+    EXPECT_EQ(near.nodes_expanded, 1);
+    EXPECT_GT(far.nodes_expanded, near.nodes_expanded);
+}
+
+// Every shortest ladder is produced exactly once
+TEST_F(WordLadderTest, AllShortestLadders) {
+    Dawg small(set<string>{"cat", "cot", "cag", "cog", "dot", "dog", "dig"});
+    set<vector<string>> ladders;
+    for (const vector<string>& ladder : all_shortest_ladders("cat", "dog", small))
+        ladders.insert(ladder);
+    EXPECT_EQ(ladders, (set<vector<string>>{
+        {"cat", "cot", "dot", "dog"},
+        {"cat", "cot", "cog", "dog"},
+        {"cat", "cag", "cog", "dog"},
+    }));
+    EXPECT_EQ(all_shortest_ladders("cat", "dog", small).count(), 3);
+    EXPECT_EQ(all_shortest_ladders("cat", "dig", small).length(), 5);
+    EXPECT_EQ(all_shortest_ladders("cat", "cat", small).begin(), all_shortest_ladders("cat", "cat", small).end());
+
+    Dawg dawg(word_list);
+    ShortestLadders many = all_shortest_ladders("code", "data", dawg);
+    EXPECT_EQ(many.length(), generate_word_ladder("code", "data", dawg).size());
+    uint64_t seen = 0;
+    for (const vector<string>& ladder : many) {
+        ASSERT_EQ(ladder.size(), many.length());
+        EXPECT_EQ(ladder.front(), "code");
+        EXPECT_EQ(ladder.back(), "data");
+        for (size_t i = 1; i < ladder.size(); ++i)
+            EXPECT_TRUE(is_adjacent(ladder[i - 1], ladder[i]));
+        ++seen;
+    }
+    EXPECT_EQ(seen, many.count());
+}
+
+// Per-query counters come out as a single JSON line
+TEST_F(WordLadderTest, LadderStatsJson) {
+    LadderStats stats;
+    vector<string> ladder = generate_word_ladder("cat", "dog", word_list, &stats);
+    ostringstream out;
+    print_ladder_stats_json(out, "cat", "dog", ladder, stats);
+    string line = out.str();
+    EXPECT_EQ(line.rfind("{\"begin\":\"cat\",\"end\":\"dog\",\"length\":4,", 0), 0) << line;
+    EXPECT_EQ(count(line.begin(), line.end(), '\n'), 1);
+#ifdef LADDER_PROFILE
+    EXPECT_EQ(stats.nodes_dequeued, stats.nodes_expanded);
+    EXPECT_GE(stats.adjacency_checks, stats.candidates_tested);
+    EXPECT_GE(stats.candidates_tested, stats.neighbor_hits);
+    EXPECT_GT(stats.peak_frontier, 0);
+    EXPECT_GT(stats.bytes_allocated, 0);
+#endif
+}
+
+// A start word with no neighbors expands itself and discovers nothing
+TEST_F(WordLadderTest, LadderStatsIsolatedStart) {
+    Dawg dawg(word_list);
+    LadderStats stats;
+    EXPECT_TRUE(generate_word_ladder("qqqqqqq", "cat", dawg, &stats).empty());
+    EXPECT_EQ(stats.nodes_expanded, 1);
+#ifdef LADDER_PROFILE
+    EXPECT_EQ(stats.candidates_tested, 0);
+    EXPECT_EQ(stats.neighbor_hits, 0);
+    EXPECT_EQ(stats.nodes_dequeued, 1);
+#endif
+}
+
+// A tiny cap forces hundreds of sorted runs, merged in more than one pass,
+// and a small edge cache, yet the disk-backed search must match the
+// in-memory one exactly
+TEST_F(DijkstrasTest, ExternalGraphMatchesInMemory) {
+    Graph large;
+    file_to_graph("../src/largest.txt", large);
+    vector<int> previous;
+    vector<int> distances = dijkstra_shortest_path(large, 0, previous);
+
+    text_to_binary_graph("../src/largest.txt", "external_graph_test.bin", 24);
+    {
+        ExternalGraph external("external_graph_test.bin", 256);
+        EXPECT_EQ(external.size(), large.size());
+        vector<int> external_previous;
+        EXPECT_EQ(dijkstra_shortest_path(external, 0, external_previous), distances);
+        EXPECT_EQ(external_previous, previous);
+        EXPECT_GT(external.block_misses(), 1u);
+    }
+
+    // A file cut short is rejected when opened, not halfway through a search
+    filesystem::resize_file("external_graph_test.bin", filesystem::file_size("external_graph_test.bin") - 4);
+    EXPECT_THROW(ExternalGraph("external_graph_test.bin"), runtime_error);
+    remove("external_graph_test.bin");
+
+    EXPECT_THROW(ExternalGraph("../src/small.txt"), runtime_error);
+
+    // A bad edge after some runs were spilled leaves no run files behind
+    ofstream("external_graph_bad.txt") << "3\n0 1 1\n1 2 1\n0 5 1\n";
+    EXPECT_THROW(text_to_binary_graph("external_graph_bad.txt", "external_graph_bad.bin", 24), runtime_error);
+    EXPECT_FALSE(filesystem::exists("external_graph_bad.bin.run0"));
+    remove("external_graph_bad.txt");
+}
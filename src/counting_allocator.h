@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+using namespace std;
+
+// Heap traffic of every container sharing one counter
+struct AllocationCounter {
+    size_t live_bytes = 0;   // allocated and not yet freed
+    size_t total_bytes = 0;  // everything ever allocated
+};
+
+// std::allocator that reports each allocation to an AllocationCounter, so
+// the footprint of a container can be measured instead of estimated. Only
+// the container's own storage is seen; malloc bookkeeping is not.
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(AllocationCounter& counter) : counter(&counter) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : counter(other.counter) {}
+
+    T* allocate(size_t n) {
+        T* p = allocator<T>().allocate(n);
+        counter->live_bytes += n * sizeof(T);
+        counter->total_bytes += n * sizeof(T);
+        return p;
+    }
+    void deallocate(T* p, size_t n) {
+        counter->live_bytes -= n * sizeof(T);
+        allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return counter == other.counter; }
+
+private:
+    template <typename U>
+    friend class CountingAllocator;
+
+    AllocationCounter* counter;
+};
@@ -0,0 +1,307 @@
+#include "dawg.h"
+#include "counting_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// Mutable node used only while building; frozen into the flat arrays after
+struct BuildNode {
+    bool final = false;
+    vector<pair<char, uint32_t>> children;
+};
+
+// Two nodes are equivalent when they agree on finality and on every child
+string signature(const BuildNode& node) {
+    string key(1, node.final ? '1' : '0');
+    for (const auto& [label, target] : node.children) {
+        key.push_back(label);
+        key.append(reinterpret_cast<const char*>(&target), sizeof(target));
+    }
+    return key;
+}
+
+// Copies of the standard containers whose heap use is counted as they are built
+using CountedString = basic_string<char, char_traits<char>, CountingAllocator<char>>;
+
+struct CountedStringHash {
+    size_t operator()(const CountedString& s) const { return hash<string_view>()(s); }
+};
+
+// Bytes the container holds once every word of `word_list` is inserted
+template <typename Container>
+size_t measured_bytes(const set<string>& word_list) {
+    AllocationCounter counter;
+    CountingAllocator<char> alloc(counter);
+    Container words(alloc);
+    for (const string& word : word_list)
+        words.emplace(word.data(), word.size(), alloc);
+    return sizeof(words) + counter.live_bytes;
+}
+
+} // namespace
+
+// Build with the incremental algorithm of Daciuk et al.: words arrive in
+// sorted order, so once a word diverges from its predecessor, the tail of
+// the predecessor can never change again and is merged with an equivalent
+// node already in the register.
+Dawg::Dawg(const set<string>& word_list) {
+    vector<BuildNode> nodes(1);
+    unordered_map<string, uint32_t> registry;
+    vector<tuple<uint32_t, char, uint32_t>> unchecked;  // (parent, label, child)
+
+    auto minimize = [&](size_t down_to) {
+        while (unchecked.size() > down_to) {
+            auto [parent, label, node] = unchecked.back();
+            unchecked.pop_back();
+            auto [it, inserted] = registry.try_emplace(signature(nodes[node]), node);
+            if (!inserted) {
+                nodes[parent].children.back().second = it->second;
+            }
+        }
+    };
+
+    string previous;
+    for (const string& word : word_list) {
+        size_t common = 0;
+        while (common < word.size() && common < previous.size() && word[common] == previous[common])
+            ++common;
+        minimize(common);
+
+        uint32_t node = unchecked.empty() ? 0 : get<2>(unchecked.back());
+        for (size_t i = common; i < word.size(); ++i) {
+            uint32_t next = nodes.size();
+            nodes.emplace_back();
+            nodes[node].children.emplace_back(word[i], next);
+            unchecked.emplace_back(node, word[i], next);
+            node = next;
+        }
+        nodes[node].final = true;
+        previous = word;
+    }
+    minimize(0);
+    word_count = word_list.size();
+
+    // Freeze the reachable nodes in breadth-first order so that each node's
+    // edges are contiguous
+    vector<uint32_t> renumber(nodes.size(), NO_NODE);
+    vector<uint32_t> order = {0};
+    renumber[0] = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const BuildNode& node = nodes[order[i]];
+        node_edges.push_back(edge_label.size());
+        node_final.push_back(node.final);
+        for (const auto& [label, target] : node.children) {
+            if (renumber[target] == NO_NODE) {
+                renumber[target] = order.size();
+                order.push_back(target);
+            }
+            edge_label.push_back(label);
+            edge_target.push_back(renumber[target]);
+        }
+    }
+    node_edges.push_back(edge_label.size());
+    node_words.assign(node_final.size(), NO_WORD);
+    count_words(0);
+
+    node_edges.shrink_to_fit();
+    node_final.shrink_to_fit();
+    edge_label.shrink_to_fit();
+    edge_target.shrink_to_fit();
+    node_words.shrink_to_fit();
+}
+
+// Words accepted from `node`, memoised; children may precede their parents
+// in breadth-first order, so this cannot be a single reverse sweep
+uint32_t Dawg::count_words(uint32_t node) {
+    if (node_words[node] == NO_WORD) {
+        uint32_t words = node_final[node];
+        for (uint32_t e = node_edges[node]; e < node_edges[node + 1]; ++e)
+            words += count_words(edge_target[e]);
+        node_words[node] = words;
+    }
+    return node_words[node];
+}
+
+uint32_t Dawg::child(uint32_t node, char c) const {
+    for (uint32_t e = node_edges[node]; e < node_edges[node + 1]; ++e) {
+        if (edge_label[e] == c)
+            return edge_target[e];
+    }
+    return NO_NODE;
+}
+
+// Node reached by reading word[pos..] from `node`, or NO_NODE
+uint32_t Dawg::follow(uint32_t node, const string& word, size_t pos) const {
+    for (; pos < word.size() && node != NO_NODE; ++pos) {
+        node = child(node, word[pos]);
+    }
+    return node;
+}
+
+bool Dawg::contains(const string& word) const {
+    if (node_final.empty())
+        return false;
+    uint32_t node = follow(0, word, 0);
+    return node != NO_NODE && node_final[node];
+}
+
+// A word's number counts the words that come before it on the way down:
+// one for each final node passed and every word under an earlier edge
+uint32_t Dawg::index_of(const string& word) const {
+    if (node_final.empty())
+        return NO_WORD;
+    uint32_t node = 0, index = 0;
+    for (char c : word) {
+        index += node_final[node];
+        uint32_t e = node_edges[node];
+        while (e < node_edges[node + 1] && edge_label[e] != c)
+            index += node_words[edge_target[e++]];
+        if (e == node_edges[node + 1])
+            return NO_WORD;
+        node = edge_target[e];
+    }
+    return node_final[node] ? index : NO_WORD;
+}
+
+string Dawg::word_at(uint32_t index) const {
+    string word;
+    uint32_t node = 0;
+    while (!(node_final[node] && index == 0)) {
+        index -= node_final[node];
+        uint32_t e = node_edges[node];
+        while (index >= node_words[edge_target[e]])
+            index -= node_words[edge_target[e++]];
+        word.push_back(edge_label[e]);
+        node = edge_target[e];
+    }
+    return word;
+}
+
+size_t Dawg::memory_bytes() const {
+    return sizeof(*this)
+        + node_edges.capacity() * sizeof(uint32_t)
+        + node_final.capacity() / 8
+        + edge_label.capacity() * sizeof(char)
+        + edge_target.capacity() * sizeof(uint32_t)
+        + node_words.capacity() * sizeof(uint32_t);
+}
+
+void Dawg::collect_length(uint32_t node, size_t length, string& prefix, vector<string>& out) const {
+    if (prefix.size() == length) {
+        if (node_final[node])
+            out.push_back(prefix);
+        return;
+    }
+    for (uint32_t e = node_edges[node]; e < node_edges[node + 1]; ++e) {
+        prefix.push_back(edge_label[e]);
+        collect_length(edge_target[e], length, prefix, out);
+        prefix.pop_back();
+    }
+}
+
+vector<string> Dawg::words_of_length(size_t length) const {
+    vector<string> out;
+    if (node_final.empty())
+        return out;
+    string prefix;
+    collect_length(0, length, prefix, out);
+    return out;
+}
+
+// Walk the automaton along `word` while the single edit is still unspent.
+// At each position the edit may be spent as a deletion of word[pos], an
+// insertion of any outgoing label, or a substitution; after that the rest
+// of the word must match exactly.
+void Dawg::collect_neighbors(uint32_t node, const string& word, size_t pos, string& prefix,
+                             vector<string>& out) const {
+    auto finish = [&](uint32_t from, size_t rest) {
+        uint32_t end = follow(from, word, rest);
+        if (end != NO_NODE && node_final[end])
+            out.push_back(prefix + word.substr(rest));
+    };
+
+    if (pos < word.size())
+        finish(node, pos + 1);  // delete word[pos]
+
+    for (uint32_t e = node_edges[node]; e < node_edges[node + 1]; ++e) {
+        char c = edge_label[e];
+        uint32_t next = edge_target[e];
+        prefix.push_back(c);
+        finish(next, pos);  // insert c before word[pos]
+        if (pos < word.size()) {
+            if (c == word[pos])
+                collect_neighbors(next, word, pos + 1, prefix, out);
+            else
+                finish(next, pos + 1);  // substitute c for word[pos]
+        }
+        prefix.pop_back();
+    }
+}
+
+vector<string> Dawg::neighbors(const string& word) const {
+    vector<string> out;
+    if (node_final.empty())
+        return out;
+    string prefix;
+    collect_neighbors(0, word, 0, prefix, out);
+
+    // Inserting or deleting one letter of a doubled pair reaches the same word twice
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+// Container memory is measured with a counting allocator: nodes, buckets
+// and out-of-line string storage, but not malloc's per-chunk overhead
+void report_dictionary_stats(const set<string>& word_list, const Dawg& dawg) {
+    unordered_set<string> hashed(word_list.begin(), word_list.end());
+
+    size_t text_bytes = 0;
+    for (const string& word : word_list)
+        text_bytes += word.size() + 1;
+    size_t set_bytes = measured_bytes<set<CountedString, less<>, CountingAllocator<CountedString>>>(word_list);
+    size_t hash_bytes = measured_bytes<unordered_set<CountedString, CountedStringHash, equal_to<>,
+                                                     CountingAllocator<CountedString>>>(word_list);
+
+    // Every word once as a hit and once, with a letter appended, as a likely miss
+    vector<string> probes;
+    probes.reserve(2 * word_list.size());
+    for (const string& word : word_list) {
+        probes.push_back(word);
+        probes.push_back(word + "q");
+    }
+
+    auto time_lookups = [&](auto&& contains) {
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string& probe : probes)
+            found += contains(probe);
+        chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+        return make_pair(elapsed.count() / probes.size(), found);
+    };
+    auto [set_ns, set_found] = time_lookups([&](const string& w) { return word_list.count(w) != 0; });
+    auto [hash_ns, hash_found] = time_lookups([&](const string& w) { return hashed.count(w) != 0; });
+    auto [dawg_ns, dawg_found] = time_lookups([&](const string& w) { return dawg.contains(w); });
+
+    cout << "Words: " << word_list.size() << " (" << text_bytes << " bytes of text)" << endl;
+    cout << "Dawg: " << dawg.node_count() << " nodes, " << dawg.edge_count() << " edges" << endl;
+    auto row = [](const string& name, size_t bytes, double ns, size_t hits) {
+        cout << left << setw(16) << name << right << setw(12) << bytes
+             << setw(12) << fixed << setprecision(1) << ns << setw(10) << hits << endl;
+    };
+    cout << left << setw(16) << "container" << right << setw(12) << "heap bytes"
+         << setw(12) << "ns/lookup" << setw(10) << "hits" << endl;
+    row("set", set_bytes, set_ns, set_found);
+    row("unordered_set", hash_bytes, hash_ns, hash_found);
+    row("dawg", dawg.memory_bytes(), dawg_ns, dawg_found);
+}
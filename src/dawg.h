@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Minimal acyclic word automaton (DAWG) frozen into flat arrays.
+// Shared prefixes and suffixes are stored once, so the whole dictionary
+// takes a fraction of the memory of a set<string> with the same words.
+class Dawg {
+public:
+    Dawg() = default;
+    explicit Dawg(const set<string>& word_list);
+
+    bool contains(const string& word) const;
+    size_t size() const { return word_count; }
+    size_t node_count() const { return node_final.size(); }
+    size_t edge_count() const { return edge_label.size(); }
+    size_t memory_bytes() const;
+
+    // Words are numbered 0..size()-1 in automaton order; NO_WORD if absent
+    static constexpr uint32_t NO_WORD = UINT32_MAX;
+    uint32_t index_of(const string& word) const;
+    string word_at(uint32_t index) const;
+
+    // Every word of exactly `length` characters, in sorted order
+    vector<string> words_of_length(size_t length) const;
+
+    // Every word one substitution, insertion or deletion away from `word`,
+    // found by walking the automaton rather than scanning the word list
+    vector<string> neighbors(const string& word) const;
+
+private:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    vector<uint32_t> node_edges;   // edges of node i are [node_edges[i], node_edges[i+1])
+    vector<bool> node_final;       // node i ends a word
+    vector<char> edge_label;
+    vector<uint32_t> edge_target;
+    vector<uint32_t> node_words;   // words accepted from node i, for numbering
+    size_t word_count = 0;
+
+    uint32_t child(uint32_t node, char c) const;
+    uint32_t follow(uint32_t node, const string& word, size_t pos) const;
+    uint32_t count_words(uint32_t node);
+    void collect_length(uint32_t node, size_t length, string& prefix, vector<string>& out) const;
+    void collect_neighbors(uint32_t node, const string& word, size_t pos, string& prefix,
+                           vector<string>& out) const;
+};
+
+// Print memory footprint and lookup speed of the Dawg next to the
+// set<string> / unordered_set<string> containers it replaces
+void report_dictionary_stats(const set<string>& word_list, const Dawg& dawg);
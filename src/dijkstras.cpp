@@ -9,36 +9,36 @@ using namespace std;
 
 // Dijkstra's algorithm to find shortest paths
 vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous) {
-    int n = G.size();
-    vector<int> distances(n, INF);
-    previous.assign(n, -1);
-    vector<bool> visited(n, false);
-    
-    distances[source] = 0;
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-    pq.push({0, source});
-    
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        int current_distance = pq.top().first;
-        pq.pop();
-        
-        if (visited[u]) continue;
-        visited[u] = true;
-        
+    DenseLabels<int> labels(G.size());
+    MinHeapFrontier<int, int> pq;
+
+    auto out_edges = [&](int u, auto&& relax) {
         for (const auto& edge : G[u]) {
-            int v = edge.dst;
-            int weight = edge.weight;
-            
-            if (!visited[v] && distances[u] + weight < distances[v]) {
-                distances[v] = distances[u] + weight;
-                previous[v] = u;
-                pq.push({distances[v], v});
-            }
+            relax(edge.dst, edge.weight);
         }
-    }
-    
-    return distances;
+    };
+    graph_search(source, out_edges, pq, labels, [](int) { return false; });
+
+    previous = move(labels.previous);
+    return move(labels.distances);
+}
+
+// Same search with the edges streamed from disk. Only per-vertex state
+// lives in memory: the labels and a decrease-key heap of at most n
+// entries, so nothing grows with the number of edges.
+vector<int> dijkstra_shortest_path(ExternalGraph& G, int source, vector<int>& previous) {
+    DenseLabels<int> labels(G.size());
+    IndexedMinHeapFrontier<int> pq(G.size());
+
+    auto out_edges = [&](int u, auto&& relax) {
+        G.for_each_edge(u, [&](int dst, int weight) {
+            relax(dst, weight);
+        });
+    };
+    graph_search(source, out_edges, pq, labels, [](int) { return false; });
+
+    previous = move(labels.previous);
+    return move(labels.distances);
 }
 
 // Extract shortest path between source and destination
@@ -4,6 +4,8 @@
 #include <queue>
 #include <limits>
 #include <stack>
+#include "graph_search.h"
+#include "external_graph.h"
 
 using namespace std;
 
@@ -48,5 +50,6 @@ inline void file_to_graph(const string& filename, Graph& G) {
 }
 
 vector<int> dijkstra_shortest_path(const Graph& G, int source, vector<int>& previous);
+vector<int> dijkstra_shortest_path(ExternalGraph& G, int source, vector<int>& previous);
 vector<int> extract_shortest_path(const vector<int>& /*distances*/, const vector<int>& previous, int destination);
 void print_path(const vector<int>& v, int total);
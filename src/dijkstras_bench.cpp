@@ -0,0 +1,110 @@
+#include "dijkstras.h"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <random>
+#include <sys/resource.h>
+
+// Semi-external Dijkstra benchmark: generates a random graph, converts it
+// to the binary edge file under a memory cap, and times the disk-backed
+// search against the in-memory one on the same source.
+//
+//   dijkstras_bench [--vertices N] [--degree D] [--cap MB] [--seed S]
+//
+// Built without sanitizers. The in-memory search runs last so its
+// adjacency lists do not inflate the peak RSS of the external run.
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Peak resident set size of the process so far
+double peak_rss_mb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+// A random ring-plus-chords graph in the text format of file_to_graph;
+// the ring keeps every vertex reachable from 0
+void write_random_graph(const string& file_name, int n, int degree, unsigned seed) {
+    mt19937 rng(seed);
+    ofstream out(file_name);
+    out << n << "\n";
+    for (int u = 0; u < n; ++u) {
+        out << u << " " << (u + 1) % n << " " << 1 + rng() % 100 << "\n";
+        for (int d = 1; d < degree; ++d)
+            out << rng() % n << " " << rng() % n << " " << 1 + rng() % 100 << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int n = 1 << 20;
+    int degree = 8;
+    size_t cap_mb = 16;
+    unsigned seed = 46;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        if (arg == "--vertices")
+            n = stoi(argv[i + 1]);
+        else if (arg == "--degree")
+            degree = stoi(argv[i + 1]);
+        else if (arg == "--cap")
+            cap_mb = stoul(argv[i + 1]);
+        else if (arg == "--seed")
+            seed = stoul(argv[i + 1]);
+    }
+    size_t cap = cap_mb << 20;
+    string text_file = "dijkstras_bench.txt", binary_file = "dijkstras_bench.bin";
+
+    auto start = Clock::now();
+    write_random_graph(text_file, n, degree, seed);
+    cout << "generate            " << fixed << setprecision(1) << setw(10) << elapsed_ms(start) << " ms  ("
+         << n << " vertices, " << uint64_t(n) * degree << " edges)" << endl;
+
+    start = Clock::now();
+    text_to_binary_graph(text_file, binary_file, cap);
+    cout << "text_to_binary_graph" << setw(10) << elapsed_ms(start) << " ms  peak " << peak_rss_mb() << " MB"
+         << endl;
+
+    vector<int> external_distances, external_previous;
+    {
+        ExternalGraph G(binary_file, cap);
+        start = Clock::now();
+        external_distances = dijkstra_shortest_path(G, 0, external_previous);
+        double ms = elapsed_ms(start);
+        uint64_t lookups = G.block_hits() + G.block_misses();
+        cout << "external dijkstra   " << setw(10) << ms << " ms  peak " << peak_rss_mb() << " MB  "
+             << setprecision(2) << G.num_edges() / ms / 1e3 << " M edges/s  " << G.bytes_read() / double(1 << 20)
+             << " MB read  " << setprecision(1) << 100.0 * G.block_hits() / max<uint64_t>(1, lookups)
+             << "% block hits  (cap " << cap_mb << " MB)" << endl;
+    }
+
+    Graph G;
+    start = Clock::now();
+    file_to_graph(text_file, G);
+    cout << "file_to_graph       " << setw(10) << elapsed_ms(start) << " ms  peak " << peak_rss_mb() << " MB"
+         << endl;
+    vector<int> previous;
+    start = Clock::now();
+    vector<int> distances = dijkstra_shortest_path(G, 0, previous);
+    double ms = elapsed_ms(start);
+    cout << "in-memory dijkstra  " << setw(10) << ms << " ms  peak " << peak_rss_mb() << " MB  "
+         << setprecision(2) << uint64_t(n) * degree / ms / 1e3 << " M edges/s" << endl;
+
+    remove(text_file.c_str());
+    remove(binary_file.c_str());
+    if (distances != external_distances) {
+        cout << "MISMATCH: external distances differ from in-memory" << endl;
+        return 1;
+    }
+    return 0;
+}
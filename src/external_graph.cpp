@@ -0,0 +1,266 @@
+#include "external_graph.h"
+#include "dijkstras.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+constexpr char MAGIC[8] = {'H', 'W', '9', 'G', 'R', 'A', 'P', 'H'};
+constexpr size_t EDGE_BYTES = 2 * sizeof(int32_t);
+constexpr size_t MAX_BLOCK_BYTES = 1 << 16;
+constexpr size_t MAX_FAN_IN = 64;  // runs open at once during a merge
+
+// One edge of a sorted run; runs keep the source, the final file does not
+struct RunEdge {
+    int32_t src;
+    int32_t dst;
+    int32_t weight;
+};
+
+void read_at(int fd, void* data, size_t bytes, uint64_t offset) {
+    char* out = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t got = pread(fd, out, bytes, offset);
+        if (got <= 0)
+            throw runtime_error("Truncated binary graph file");
+        out += got;
+        bytes -= got;
+        offset += got;
+    }
+}
+
+template <typename T>
+void write_value(ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// k-way merge of runs [first, last), calling emit(edge) in source order.
+// Ties go to the earlier run, so each vertex keeps its edges in input
+// order. Returns the number of edges emitted.
+template <typename Emit>
+uint64_t merge_runs(const vector<string>& runs, size_t first, size_t last, Emit&& emit) {
+    vector<ifstream> readers;
+    for (size_t run = first; run < last; ++run) {
+        readers.emplace_back(runs[run], ios::binary);
+        if (!readers.back()) {
+            throw runtime_error("Can't read " + runs[run]);
+        }
+    }
+
+    using Head = pair<RunEdge, size_t>;
+    auto later = [](const Head& a, const Head& b) {
+        return a.first.src != b.first.src ? a.first.src > b.first.src : a.second > b.second;
+    };
+    priority_queue<Head, vector<Head>, decltype(later)> heads(later);
+    auto advance = [&](size_t reader) {
+        RunEdge e;
+        if (readers[reader].read(reinterpret_cast<char*>(&e), sizeof(e)))
+            heads.emplace(e, reader);
+    };
+    for (size_t reader = 0; reader < readers.size(); ++reader)
+        advance(reader);
+
+    uint64_t merged = 0;
+    while (!heads.empty()) {
+        auto [e, reader] = heads.top();
+        heads.pop();
+        emit(e);
+        ++merged;
+        advance(reader);
+    }
+    return merged;
+}
+
+void remove_files(const vector<string>& files) {
+    for (const string& file : files)
+        remove(file.c_str());
+}
+
+// Temporary run files, removed however the conversion ends
+struct RunFiles {
+    vector<string> names;
+    ~RunFiles() { remove_files(names); }
+};
+
+} // namespace
+
+ExternalGraph::ExternalGraph(const string& file_name, size_t memory_cap) {
+    fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Can't open input file");
+    }
+
+    try {
+        char magic[sizeof(MAGIC)];
+        uint64_t header[2];
+        read_at(fd, magic, sizeof(magic), 0);
+        read_at(fd, header, sizeof(header), sizeof(magic));
+        if (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw runtime_error("Not a binary graph file: " + file_name);
+        }
+
+        struct stat info;
+        if (header[0] > uint64_t(INT32_MAX) || fstat(fd, &info) != 0
+            || uint64_t(info.st_size) < sizeof(magic) + sizeof(header) + (header[0] + 1) * sizeof(uint64_t)) {
+            throw runtime_error("Truncated binary graph file: " + file_name);
+        }
+
+        numVertices = header[0];
+        offsets.resize(numVertices + 1);
+        read_at(fd, offsets.data(), offsets.size() * sizeof(uint64_t), sizeof(magic) + sizeof(header));
+        edges_start = sizeof(magic) + sizeof(header) + offsets.size() * sizeof(uint64_t);
+
+        // Offsets must rise from 0 to the edge count, and the edges must fill the rest of the file
+        bool ordered = offsets[0] == 0 && is_sorted(offsets.begin(), offsets.end());
+        if (!ordered || offsets.back() != header[1] || uint64_t(info.st_size) != edges_start + header[1] * EDGE_BYTES) {
+            throw runtime_error("Corrupt binary graph file: " + file_name);
+        }
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+
+    // Dijkstra visits vertices in distance order, not file order, so blocks
+    // are kept small (64 KiB) and many; at least two must fit in the cap
+    size_t block_bytes = clamp(memory_cap / 2, EDGE_BYTES, MAX_BLOCK_BYTES) / EDGE_BYTES * EDGE_BYTES;
+    edges_per_block = block_bytes / EDGE_BYTES;
+    slots.resize(max<size_t>(1, memory_cap / block_bytes));
+    for (size_t i = 0; i < slots.size(); ++i)
+        slots[i].position = recency.insert(recency.end(), i);
+}
+
+ExternalGraph::~ExternalGraph() {
+    if (fd >= 0)
+        close(fd);
+}
+
+// Least recently used block is evicted on a miss. High-degree vertices
+// span several blocks, so the next one is requested from the kernel ahead
+// of time.
+const int32_t* ExternalGraph::edge_block(uint64_t block) {
+    auto found = slot_of.find(block);
+    if (found != slot_of.end()) {
+        ++hits;
+        Slot& slot = slots[found->second];
+        recency.splice(recency.begin(), recency, slot.position);
+        return slot.edges.data();
+    }
+
+    ++misses;
+    size_t victim = recency.back();
+    Slot& slot = slots[victim];
+    recency.splice(recency.begin(), recency, slot.position);
+    if (slot.block != UINT64_MAX)
+        slot_of.erase(slot.block);
+
+    uint64_t first = block * edges_per_block;
+    uint64_t count = min(edges_per_block, num_edges() - first);
+    slot.edges.resize(2 * count);
+    read_at(fd, slot.edges.data(), count * EDGE_BYTES, edges_start + first * EDGE_BYTES);
+    read_bytes += count * EDGE_BYTES;
+#ifdef POSIX_FADV_WILLNEED
+    posix_fadvise(fd, edges_start + (first + count) * EDGE_BYTES, edges_per_block * EDGE_BYTES,
+                  POSIX_FADV_WILLNEED);
+#endif
+
+    slot.block = block;
+    slot_of[block] = victim;
+    return slot.edges.data();
+}
+
+void text_to_binary_graph(const string& text_file, const string& binary_file, size_t memory_cap) {
+    ifstream in(text_file);
+    if (!in) {
+        throw runtime_error("Can't open input file");
+    }
+    int n = 0;
+    if (!(in >> n) || n < 0) {
+        throw runtime_error("Unable to find input file");
+    }
+
+    // Pass 1: count out-degrees and spill source-sorted runs of edges
+    vector<uint64_t> degree(n, 0);
+    // The buffer and stable_sort's scratch copy share the cap, and the
+    // buffer is reserved up front so it never reallocates
+    RunFiles runs;
+    vector<RunEdge> buffer;
+    size_t run_edges = max<size_t>(1, memory_cap / (2 * sizeof(RunEdge)));
+    buffer.reserve(run_edges);
+    auto spill = [&] {
+        stable_sort(buffer.begin(), buffer.end(), [](const RunEdge& a, const RunEdge& b) { return a.src < b.src; });
+        runs.names.push_back(binary_file + ".run" + to_string(runs.names.size()));
+        ofstream run(runs.names.back(), ios::binary | ios::trunc);
+        run.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(RunEdge));
+        if (!run) {
+            throw runtime_error("Can't write " + runs.names.back());
+        }
+        buffer.clear();
+    };
+    for (Edge e; in >> e;) {
+        if (e.src < 0 || e.src >= n || e.dst < 0 || e.dst >= n) {
+            throw runtime_error("Edge endpoint out of range in " + text_file);
+        }
+        ++degree[e.src];
+        buffer.push_back({e.src, e.dst, e.weight});
+        if (buffer.size() == run_edges)
+            spill();
+    }
+    if (!buffer.empty())
+        spill();
+    vector<RunEdge>().swap(buffer);
+
+    // Merge groups of runs into longer ones until a single pass can take
+    // them all, so a small cap never opens more than MAX_FAN_IN files
+    for (size_t pass = 0; runs.names.size() > MAX_FAN_IN; ++pass) {
+        RunFiles merged;
+        for (size_t first = 0; first < runs.names.size(); first += MAX_FAN_IN) {
+            merged.names.push_back(binary_file + ".pass" + to_string(pass) + ".run" + to_string(merged.names.size()));
+            ofstream run(merged.names.back(), ios::binary | ios::trunc);
+            merge_runs(runs.names, first, min(runs.names.size(), first + MAX_FAN_IN),
+                       [&](const RunEdge& e) { write_value(run, e); });
+            if (!run) {
+                throw runtime_error("Can't write " + merged.names.back());
+            }
+        }
+        swap(runs.names, merged.names);  // the previous pass's runs go with `merged`
+    }
+
+    // Header and offsets, then the final merge, which keeps each vertex's
+    // edges in input order exactly as file_to_graph would
+    ofstream out(binary_file, ios::binary | ios::trunc);
+    if (!out) {
+        throw runtime_error("Can't write " + binary_file);
+    }
+    out.write(MAGIC, sizeof(MAGIC));
+    uint64_t total = 0;
+    for (uint64_t d : degree)
+        total += d;
+    write_value(out, uint64_t(n));
+    write_value(out, total);
+    uint64_t offset = 0;
+    write_value(out, offset);
+    for (uint64_t d : degree) {
+        offset += d;
+        write_value(out, offset);
+    }
+
+    uint64_t merged = merge_runs(runs.names, 0, runs.names.size(), [&](const RunEdge& e) {
+        write_value(out, e.dst);
+        write_value(out, e.weight);
+    });
+    if (merged != total) {
+        throw runtime_error("Lost edges while merging the runs of " + binary_file);
+    }
+    if (!out) {
+        throw runtime_error("Can't write " + binary_file);
+    }
+}
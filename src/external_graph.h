@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Semi-external graph for Dijkstra on graphs whose edges do not fit in RAM.
+// Per-vertex state (edge offsets here, distances and predecessors in the
+// search) stays in memory; the edges stay in a source-sorted binary file
+// and are read in blocks through an LRU cache bounded by a memory cap.
+//
+// File layout, in host byte order (written and read on the same machine):
+//   char[8]   "HW9GRAPH"
+//   uint64    number of vertices n
+//   uint64    number of edges m
+//   uint64    offsets[n + 1]   edges of u are [offsets[u], offsets[u + 1])
+//   int32     (dst, weight) x m, grouped by source
+class ExternalGraph {
+public:
+    static constexpr size_t DEFAULT_MEMORY_CAP = 64 << 20;
+
+    // `memory_cap` bounds the edge cache in bytes
+    explicit ExternalGraph(const string& file_name, size_t memory_cap = DEFAULT_MEMORY_CAP);
+    ~ExternalGraph();
+    ExternalGraph(const ExternalGraph&) = delete;
+    ExternalGraph& operator=(const ExternalGraph&) = delete;
+
+    int numVertices = 0;
+    size_t size() const { return numVertices; }
+    uint64_t num_edges() const { return offsets.back(); }
+
+    // Call visit(dst, weight) for every edge leaving u. Not const: reading
+    // fills the block cache, so one graph serves one search at a time.
+    template <typename Visit>
+    void for_each_edge(int u, Visit&& visit) {
+        for (uint64_t e = offsets[u]; e < offsets[u + 1];) {
+            const int32_t* block = edge_block(e / edges_per_block);
+            uint64_t block_end = min(offsets[u + 1], (e / edges_per_block + 1) * edges_per_block);
+            for (; e < block_end; ++e) {
+                const int32_t* edge = block + 2 * (e % edges_per_block);
+                visit(edge[0], edge[1]);
+            }
+        }
+    }
+
+    uint64_t bytes_read() const { return read_bytes; }
+    uint64_t block_hits() const { return hits; }
+    uint64_t block_misses() const { return misses; }
+
+private:
+    struct Slot {
+        uint64_t block = UINT64_MAX;
+        list<size_t>::iterator position;  // place in `recency`
+        vector<int32_t> edges;
+    };
+
+    int fd = -1;
+    vector<uint64_t> offsets;
+    uint64_t edges_start = 0;     // file offset of the first edge
+    uint64_t edges_per_block = 0;
+
+    vector<Slot> slots;
+    unordered_map<uint64_t, size_t> slot_of;  // block -> slot
+    list<size_t> recency;                     // slots, most recent first
+    uint64_t read_bytes = 0, hits = 0, misses = 0;
+
+    const int32_t* edge_block(uint64_t block);
+};
+
+// Convert the text format read by file_to_graph into the binary format
+// above. Edges are sorted by source with an external merge sort, holding
+// at most `memory_cap` bytes of edges in memory at once.
+void text_to_binary_graph(const string& text_file, const string& binary_file,
+                          size_t memory_cap = ExternalGraph::DEFAULT_MEMORY_CAP);
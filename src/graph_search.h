@@ -0,0 +1,293 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// One best-first search shared by Dijkstra and the word ladder. Everything
+// that differs between them is a template policy, so each caller compiles
+// to its own specialised loop with no virtual calls:
+//   neighbors(u, relax)  calls relax(v, weight) for every edge u -> v
+//   frontier             which tentative node is expanded next
+//   labels               distances, predecessors and the visited set
+
+// Where a search may stop once the goal is known. Stopping when the goal is
+// discovered is only correct for unit weights with a FIFO frontier.
+enum class StopAt { settled, discovered };
+
+template <typename Q>
+concept Frontier = requires(Q& q, const typename Q::node_type& u, typename Q::weight_type w) {
+    { q.empty() } -> convertible_to<bool>;
+    { q.size() } -> convertible_to<size_t>;
+    q.push(w, u);
+    { q.pop() } -> same_as<pair<typename Q::weight_type, typename Q::node_type>>;
+};
+
+template <typename L, typename Node, typename Weight>
+concept LabelStore = requires(L& labels, const Node& u, Weight w) {
+    labels.start(u);                                   // u is the source, at distance 0
+    { labels.relax(u, w, u) } -> convertible_to<bool>; // record a shorter distance and predecessor
+    { labels.settle(u) } -> convertible_to<bool>;      // false if u was already settled
+};
+
+template <typename F, typename Node, typename Weight>
+concept NeighborGenerator = requires(F& neighbors, const Node& u, void (*relax)(const Node&, Weight)) {
+    neighbors(u, relax);
+};
+
+struct SearchResult {
+    bool reached = false;   // the goal predicate accepted some node
+    size_t expanded = 0;    // nodes settled and handed to the neighbor generator
+};
+
+// Binary heap ordered by distance; the general case for non-negative weights
+template <typename Node, typename Weight>
+class MinHeapFrontier {
+public:
+    using node_type = Node;
+    using weight_type = Weight;
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void push(Weight w, const Node& u) { heap.emplace(w, u); }
+    pair<Weight, Node> pop() {
+        pair<Weight, Node> top = heap.top();
+        heap.pop();
+        return top;
+    }
+
+private:
+    priority_queue<pair<Weight, Node>, vector<pair<Weight, Node>>, greater<pair<Weight, Node>>> heap;
+};
+
+// Binary heap over nodes 0..n-1 with decrease-key. Each node is held at
+// most once, so the heap never exceeds n entries, where a lazy heap keeps
+// one per successful relaxation.
+template <typename Weight>
+class IndexedMinHeapFrontier {
+public:
+    using node_type = int;
+    using weight_type = Weight;
+
+    explicit IndexedMinHeapFrontier(size_t n) : position(n, ABSENT) {}
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void push(Weight w, int u) {
+        if (position[u] == ABSENT) {
+            position[u] = heap.size();
+            heap.emplace_back(w, u);
+        } else if (w < heap[position[u]].first) {
+            heap[position[u]].first = w;
+        } else {
+            return;
+        }
+        sift_up(position[u]);
+    }
+    pair<Weight, int> pop() {
+        pair<Weight, int> top = heap.front();
+        position[top.second] = ABSENT;
+        heap.front() = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            position[heap.front().second] = 0;
+            sift_down(0);
+        }
+        return top;
+    }
+
+private:
+    static constexpr int ABSENT = -1;
+
+    vector<pair<Weight, int>> heap;  // ordered like MinHeapFrontier: distance, then node
+    vector<int> position;            // index of each node in `heap`, or ABSENT
+
+    void swap_entries(size_t a, size_t b) {
+        swap(heap[a], heap[b]);
+        position[heap[a].second] = a;
+        position[heap[b].second] = b;
+    }
+    void sift_up(size_t i) {
+        while (i > 0 && heap[i] < heap[(i - 1) / 2]) {
+            swap_entries(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+    void sift_down(size_t i) {
+        for (;;) {
+            size_t smallest = i;
+            for (size_t child = 2 * i + 1; child <= 2 * i + 2 && child < heap.size(); ++child) {
+                if (heap[child] < heap[smallest])
+                    smallest = child;
+            }
+            if (smallest == i)
+                return;
+            swap_entries(i, smallest);
+            i = smallest;
+        }
+    }
+};
+
+// Plain queue; distances come out in order when every edge has the same weight
+template <typename Node, typename Weight, template <typename> class Alloc = allocator>
+class FifoFrontier {
+public:
+    using node_type = Node;
+    using weight_type = Weight;
+
+    FifoFrontier() = default;
+    explicit FifoFrontier(const Alloc<char>& alloc) : fifo(Alloc<pair<Weight, Node>>(alloc)) {}
+
+    bool empty() const { return fifo.empty(); }
+    size_t size() const { return fifo.size(); }
+    void push(Weight w, const Node& u) { fifo.emplace(w, u); }
+    pair<Weight, Node> pop() {
+        pair<Weight, Node> front = move(fifo.front());
+        fifo.pop();
+        return front;
+    }
+
+private:
+    queue<pair<Weight, Node>, deque<pair<Weight, Node>, Alloc<pair<Weight, Node>>>> fifo;
+};
+
+// Labels for nodes numbered 0..n-1, kept in flat vectors
+template <typename Weight>
+struct DenseLabels {
+    vector<Weight> distances;
+    vector<int> previous;
+    vector<bool> done;
+
+    explicit DenseLabels(size_t n)
+        : distances(n, numeric_limits<Weight>::max()), previous(n, -1), done(n, false) {}
+
+    void start(int u) { distances[u] = Weight{}; }
+    bool relax(int v, Weight w, int u) {
+        if (done[v] || !(w < distances[v]))
+            return false;
+        distances[v] = w;
+        previous[v] = u;
+        return true;
+    }
+    bool settle(int u) {
+        if (done[u])
+            return false;
+        done[u] = true;
+        return true;
+    }
+    bool discovered(int u) const { return distances[u] != numeric_limits<Weight>::max(); }
+};
+
+// Labels for arbitrary hashable nodes, created as nodes are discovered
+template <typename Node, typename Weight, template <typename> class Alloc = allocator>
+class HashLabels {
+public:
+    HashLabels() = default;
+    explicit HashLabels(const Alloc<char>& alloc) : labels(LabelAlloc(alloc)) {}
+
+    void start(const Node& u) {
+        Label& label = labels[u];
+        label.distance = Weight{};
+        label.is_source = true;
+    }
+    bool relax(const Node& v, Weight w, const Node& u) {
+        Label& label = labels.try_emplace(v).first->second;
+        if (label.settled || !(w < label.distance))
+            return false;
+        label.distance = w;
+        label.previous = u;
+        return true;
+    }
+    bool settle(const Node& u) {
+        Label& label = labels.find(u)->second;
+        if (label.settled)
+            return false;
+        label.settled = true;
+        return true;
+    }
+    bool discovered(const Node& u) const { return labels.count(u) != 0; }
+    size_t size() const { return labels.size(); }
+
+    // Nodes from the source to `goal`, following recorded predecessors
+    vector<Node> path_to(const Node& goal) const {
+        vector<Node> path;
+        for (auto it = labels.find(goal); it != labels.end(); it = labels.find(it->second.previous)) {
+            path.push_back(it->first);
+            if (it->second.is_source)
+                break;
+        }
+        return vector<Node>(path.rbegin(), path.rend());
+    }
+
+private:
+    struct Label {
+        Weight distance = numeric_limits<Weight>::max();
+        Node previous{};
+        bool settled = false;
+        bool is_source = false;
+    };
+    using LabelAlloc = Alloc<pair<const Node, Label>>;
+    unordered_map<Node, Label, hash<Node>, equal_to<Node>, LabelAlloc> labels;
+};
+
+// Best-first search from `source` until `is_goal` accepts a node (at the
+// point chosen by `stop_at`) or the frontier runs dry
+template <StopAt stop_at = StopAt::settled, Frontier Queue, typename Labels, typename Neighbors, typename Goal>
+    requires LabelStore<Labels, typename Queue::node_type, typename Queue::weight_type>
+          && NeighborGenerator<Neighbors, typename Queue::node_type, typename Queue::weight_type>
+          && predicate<Goal&, const typename Queue::node_type&>
+SearchResult graph_search(const typename Queue::node_type& source, Neighbors&& neighbors,
+                          Queue& frontier, Labels& labels, Goal&& is_goal) {
+    using Node = typename Queue::node_type;
+    using Weight = typename Queue::weight_type;
+
+    SearchResult result;
+    labels.start(source);
+    if constexpr (stop_at == StopAt::discovered) {
+        if (is_goal(source)) {
+            result.reached = true;
+            return result;
+        }
+    }
+    frontier.push(Weight{}, source);
+
+    while (!frontier.empty()) {
+        auto [distance, u] = frontier.pop();
+        if (!labels.settle(u))
+            continue;  // stale heap entry
+        ++result.expanded;
+
+        if constexpr (stop_at == StopAt::settled) {
+            if (is_goal(u)) {
+                result.reached = true;
+                return result;
+            }
+        }
+
+        const Weight d = distance;
+        const Node& from = u;
+        neighbors(from, [&](const Node& v, Weight w) {
+            if (result.reached || !labels.relax(v, d + w, from))
+                return;
+            if constexpr (stop_at == StopAt::discovered) {
+                if (is_goal(v)) {
+                    result.reached = true;
+                    return;
+                }
+            }
+            frontier.push(d + w, v);
+        });
+        if (result.reached)
+            return result;
+    }
+    return result;
+}
@@ -1,4 +1,6 @@
 #include "ladder.h"
+#include "graph_search.h"
+#include "counting_allocator.h"
 #include <iostream>
 #include <fstream>
 #include <queue>
@@ -17,6 +19,67 @@
 
 using namespace std;
 
+#ifdef LADDER_PROFILE
+namespace {
+
+thread_local size_t adjacency_checks = 0;
+
+double ms_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Fills in the is_adjacent counter for the whole call, including the
+// dictionary scan of the set<string> overload
+class ProfileScope {
+public:
+    explicit ProfileScope(LadderStats* stats) : stats(stats), adjacency_before(adjacency_checks) {}
+    ~ProfileScope() {
+        if (stats)
+            stats->adjacency_checks = adjacency_checks - adjacency_before;
+    }
+
+private:
+    LadderStats* stats;
+    size_t adjacency_before;
+};
+
+// Frontier adaptor that counts and times the queue work of the one it wraps
+template <typename Queue>
+class ProfiledFrontier {
+public:
+    using node_type = typename Queue::node_type;
+    using weight_type = typename Queue::weight_type;
+
+    ProfiledFrontier(Queue& inner, LadderStats& stats) : inner(inner), stats(stats) {}
+
+    bool empty() const { return inner.empty(); }
+    size_t size() const { return inner.size(); }
+    void push(weight_type w, const node_type& u) {
+        auto start = chrono::steady_clock::now();
+        inner.push(w, u);
+        stats.peak_frontier = max(stats.peak_frontier, inner.size());
+        stats.queue_ms += ms_since(start);
+    }
+    pair<weight_type, node_type> pop() {
+        auto start = chrono::steady_clock::now();
+        pair<weight_type, node_type> top = inner.pop();
+        ++stats.nodes_dequeued;
+        stats.queue_ms += ms_since(start);
+        return top;
+    }
+
+private:
+    Queue& inner;
+    LadderStats& stats;
+};
+
+} // namespace
+
+#define LADDER_PROFILE_SCOPE(stats) ProfileScope profile_scope(stats)
+#else
+#define LADDER_PROFILE_SCOPE(stats)
+#endif
+
 // Utility function to convert string to lowercase
 string to_lower(string word) {
     transform(word.begin(), word.end(), word.begin(), ::tolower);
@@ -66,6 +129,9 @@ bool edit_distance_within(const string& str1, const string& str2, int d) {
 
 // Check if two words are adjacent
 bool is_adjacent(const string& word1, const string& word2) {
+#ifdef LADDER_PROFILE
+    ++adjacency_checks;
+#endif
     return edit_distance_within(word1, word2, 1);
 }
 
@@ -83,12 +149,65 @@ void load_words(set<string>& word_list, const string& file_name) {
     }
 }
 
+namespace {
+
+// BFS from start until goal is discovered, over whatever neighbors the
+// dictionary reports; every overload below is a thin wrapper around this
+template <typename Neighbors>
+vector<string> search_ladder(const string& start, const string& goal, Neighbors&& neighbors,
+                             LadderStats* stats) {
+    auto is_goal = [&](const string& word) { return word == goal; };
+
+#ifdef LADDER_PROFILE
+    // The search's own containers count what they allocate
+    AllocationCounter allocations;
+    CountingAllocator<char> alloc(allocations);
+    HashLabels<string, int, CountingAllocator> visited(alloc);
+    FifoFrontier<string, int, CountingAllocator> word_queue(alloc);
+
+    // Time spent in the generator, minus the frontier pushes it triggers,
+    // is charged to the index
+    LadderStats profile;
+    ProfiledFrontier<FifoFrontier<string, int, CountingAllocator>> frontier(word_queue, profile);
+    auto profiled_neighbors = [&](const string& word, auto&& relax) {
+        double queue_before = profile.queue_ms;
+        auto begin = chrono::steady_clock::now();
+        neighbors(word, [&](const string& candidate, int weight) {
+            ++profile.candidates_tested;
+            bool seen = visited.discovered(candidate);
+            relax(candidate, weight);
+            profile.neighbor_hits += !seen && visited.discovered(candidate);
+        });
+        profile.index_ms += ms_since(begin) - (profile.queue_ms - queue_before);
+    };
+    SearchResult result = graph_search<StopAt::discovered>(start, profiled_neighbors, frontier, visited, is_goal);
+    profile.bytes_allocated = allocations.total_bytes;
+    if (stats) {
+        *stats = profile;  // ProfileScope adds the adjacency count on return
+    }
+#else
+    HashLabels<string, int> visited;
+    FifoFrontier<string, int> word_queue;
+    SearchResult result = graph_search<StopAt::discovered>(start, neighbors, word_queue, visited, is_goal);
+#endif
+    if (stats) {
+        stats->nodes_expanded = result.expanded;
+    }
+    if (!result.reached)
+        return {};
+    return visited.path_to(goal);
+}
+
+} // namespace
+
 // Optimized word ladder generation
 vector<string> generate_word_ladder(
     const string& begin_word, 
     const string& end_word, 
-    const set<string>& word_list
+    const set<string>& word_list,
+    LadderStats* stats
 ) {
+    LADDER_PROFILE_SCOPE(stats);
     // Convert words to lowercase
     string start = to_lower(begin_word);
     string goal = to_lower(end_word);
@@ -98,55 +217,215 @@ vector<string> generate_word_ladder(
         return {};  // Return empty vector instead of {start}
     }
 
-    // Convert word_list to unordered_set for faster lookups
-    unordered_set<string> dictionary(word_list.begin(), word_list.end());
-
     // Predefined ladder for specific test case
     if (start == "awake" && goal == "sleep") {
         return {"awake", "aware", "ware", "were", "wee", "see", "seep", "sleep"};
     }
 
-    // Queue for BFS
-    queue<vector<string>> ladder_queue;
-    unordered_set<string> visited;
+    // Hash order decides which of several shortest ladders is found first
+    unordered_set<string> dictionary(word_list.begin(), word_list.end());
 
-    // Initialize with start word
-    ladder_queue.push({start});
-    visited.insert(start);
+    // Every adjacent dictionary word is an edge. The cheap length test inside
+    // is_adjacent rejects most words before any hashing, so the visited check
+    // is left to the search.
+    auto adjacent_words = [&](const string& last_word, auto&& relax) {
+        for (const string& candidate : dictionary) {
+            if (is_adjacent(last_word, candidate))
+                relax(candidate, 1);
+        }
+    };
+    return search_ladder(start, goal, adjacent_words, stats);
+}
 
-    while (!ladder_queue.empty()) {
-        // Get current ladder
-        vector<string> current_ladder = ladder_queue.front();
-        ladder_queue.pop();
+// Word ladder over a Dawg: neighbors come from walking the automaton
+vector<string> generate_word_ladder(
+    const string& begin_word,
+    const string& end_word,
+    const Dawg& dictionary,
+    LadderStats* stats
+) {
+    LADDER_PROFILE_SCOPE(stats);
+    string start = to_lower(begin_word);
+    string goal = to_lower(end_word);
 
-        // Get last word in current ladder
-        string last_word = current_ladder.back();
+    if (start == goal || !dictionary.contains(goal)) {
+        return {};
+    }
 
-        // Try every word in dictionary
-        for (const string& candidate : dictionary) {
-            // Skip if already visited
-            if (visited.count(candidate)) continue;
-
-            // Check if candidate is adjacent to last word
-            if (is_adjacent(last_word, candidate)) {
-                // Create new ladder
-                vector<string> new_ladder = current_ladder;
-                new_ladder.push_back(candidate);
-
-                // Check if goal reached
-                if (candidate == goal) {
-                    return new_ladder;
-                }
-
-                // Mark as visited and enqueue
-                visited.insert(candidate);
-                ladder_queue.push(new_ladder);
-            }
+    auto dawg_neighbors = [&](const string& word, auto&& relax) {
+        for (const string& candidate : dictionary.neighbors(word))
+            relax(candidate, 1);
+    };
+    return search_ladder(start, goal, dawg_neighbors, stats);
+}
+
+// Word ladder over one version of a LiveDictionary; writers publishing
+// newer versions meanwhile do not affect the search
+vector<string> generate_word_ladder(
+    const string& begin_word,
+    const string& end_word,
+    const LiveDictionary::Snapshot& dictionary,
+    LadderStats* stats
+) {
+    LADDER_PROFILE_SCOPE(stats);
+    string start = to_lower(begin_word);
+    string goal = to_lower(end_word);
+
+    if (start == goal || !dictionary.contains(goal)) {
+        return {};
+    }
+
+    auto indexed_neighbors = [&](const string& word, auto&& relax) {
+        for (const string& candidate : dictionary.neighbors(word))
+            relax(candidate, 1);
+    };
+    return search_ladder(start, goal, indexed_neighbors, stats);
+}
+
+namespace {
+
+// Label store for the layered BFS: keeps every predecessor that reaches a
+// word at its shortest distance, not only the first one
+struct LayeredLabels {
+    vector<int> distance;
+    vector<bool> done;
+    vector<pair<uint32_t, uint32_t>> edges;  // (word, predecessor)
+
+    explicit LayeredLabels(size_t n) : distance(n, numeric_limits<int>::max()), done(n, false) {}
+
+    void start(uint32_t u) { distance[u] = 0; }
+    bool relax(uint32_t v, int w, uint32_t u) {
+        if (done[v] || w > distance[v])
+            return false;
+        edges.emplace_back(v, u);
+        if (w == distance[v])
+            return false;
+        distance[v] = w;
+        return true;
+    }
+    bool settle(uint32_t u) {
+        if (done[u])
+            return false;
+        done[u] = true;
+        return true;
+    }
+};
+
+} // namespace
+
+ShortestLadders::ShortestLadders(const string& begin_word, const string& end_word, const Dawg& dictionary)
+    : dictionary(&dictionary), start(to_lower(begin_word)) {
+    string goal = to_lower(end_word);
+    uint32_t goal_id = dictionary.index_of(goal);
+    if (start == goal || goal_id == Dawg::NO_WORD) {
+        return;
+    }
+
+    // A start word outside the dictionary gets the first unused number
+    start_id = dictionary.index_of(start);
+    if (start_id == Dawg::NO_WORD) {
+        start_id = dictionary.size();
+    }
+
+    // Stopping when the goal is settled, not discovered, means its whole
+    // layer of predecessors has been expanded
+    LayeredLabels labels(dictionary.size() + 1);
+    FifoFrontier<uint32_t, int> frontier;
+    auto neighbor_ids = [&](uint32_t u, auto&& relax) {
+        for (const string& candidate : dictionary.neighbors(word_of_id(u)))
+            relax(dictionary.index_of(candidate), 1);
+    };
+    auto is_goal = [&](uint32_t u) { return u == goal_id; };
+    if (!graph_search(start_id, neighbor_ids, frontier, labels, is_goal).reached) {
+        return;
+    }
+    ladder_length = labels.distance[goal_id] + 1;
+
+    // Walk back from the goal, keeping only predecessors on some shortest
+    // ladder and renumbering them densely; node 0 is the goal
+    vector<pair<uint32_t, uint32_t>>& edges = labels.edges;
+    sort(edges.begin(), edges.end());
+    unordered_map<uint32_t, uint32_t> node_of = {{goal_id, 0}};
+    word.push_back(goal_id);
+    for (size_t node = 0; node < word.size(); ++node) {
+        first_pred.push_back(preds.size());
+        auto first = lower_bound(edges.begin(), edges.end(), make_pair(word[node], uint32_t(0)));
+        for (auto it = first; it != edges.end() && it->first == word[node]; ++it) {
+            auto [entry, added] = node_of.try_emplace(it->second, word.size());
+            if (added)
+                word.push_back(it->second);
+            preds.push_back(entry->second);
+        }
+    }
+    first_pred.push_back(preds.size());
+}
+
+ShortestLadders all_shortest_ladders(const string& begin_word, const string& end_word, const Dawg& dictionary) {
+    return ShortestLadders(begin_word, end_word, dictionary);
+}
+
+string ShortestLadders::word_of_id(uint32_t id) const {
+    return id == start_id ? start : dictionary->word_at(id);
+}
+
+// Predecessors always lie one layer further from the goal and so get larger
+// node numbers, which lets the count run as a single reverse sweep
+uint64_t ShortestLadders::count() const {
+    if (word.empty())
+        return 0;
+    vector<uint64_t> ladders(word.size());
+    for (size_t node = word.size(); node-- > 0;) {
+        if (pred_count(node) == 0) {
+            ladders[node] = 1;
+            continue;
+        }
+        uint64_t total = 0;
+        for (uint32_t i = first_pred[node]; i < first_pred[node + 1]; ++i) {
+            uint64_t through = ladders[preds[i]];
+            total = total > numeric_limits<uint64_t>::max() - through ? numeric_limits<uint64_t>::max()
+                                                                         : total + through;
         }
+        ladders[node] = total;
     }
+    return ladders[0];
+}
 
-    // No ladder found, return empty vector
-    return {};
+ShortestLadders::iterator::iterator(const ShortestLadders* owner) : owner(owner), path{0} {
+    descend(0);
+}
+
+// Complete the path below position `from` by always taking the first
+// predecessor, and refresh the affected end of the ladder
+void ShortestLadders::iterator::descend(size_t from) {
+    path.resize(from + 1);
+    choice.resize(from);
+    while (owner->pred_count(path.back()) > 0) {
+        choice.push_back(0);
+        path.push_back(owner->preds[owner->first_pred[path.back()]]);
+    }
+    ladder.resize(path.size());
+    for (size_t i = from; i < path.size(); ++i) {
+        ladder[path.size() - 1 - i] = owner->word_of_id(owner->word[path[i]]);
+    }
+}
+
+// Odometer step: advance the deepest position that has another
+// predecessor left, then take first choices below it
+ShortestLadders::iterator& ShortestLadders::iterator::operator++() {
+    for (size_t i = choice.size(); i-- > 0;) {
+        if (choice[i] + 1 < owner->pred_count(path[i])) {
+            ++choice[i];
+            path.resize(i + 1);
+            choice.resize(i + 1);
+            path.push_back(owner->preds[owner->first_pred[path[i]] + choice[i]]);
+            descend(i + 1);
+            return *this;
+        }
+    }
+    path.clear();
+    choice.clear();
+    ladder.clear();
+    return *this;
 }
 
 // Print word ladder
@@ -163,6 +442,34 @@ void print_word_ladder(const vector<string>& ladder) {
     cout << endl;
 }
 
+// One JSON object per query, on a single line
+void print_ladder_stats_json(ostream& out, const string& begin_word, const string& end_word,
+                             const vector<string>& ladder, const LadderStats& stats) {
+    auto quoted = [](const string& text) {
+        string json = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                json.push_back('\\');
+            json.push_back(c);
+        }
+        return json + "\"";
+    };
+
+    out << "{\"begin\":" << quoted(begin_word) << ",\"end\":" << quoted(end_word)
+        << ",\"length\":" << ladder.size() << ",\"nodes_expanded\":" << stats.nodes_expanded;
+#ifdef LADDER_PROFILE
+    out << ",\"nodes_dequeued\":" << stats.nodes_dequeued
+        << ",\"candidates_tested\":" << stats.candidates_tested
+        << ",\"adjacency_checks\":" << stats.adjacency_checks
+        << ",\"neighbor_hits\":" << stats.neighbor_hits
+        << ",\"peak_frontier\":" << stats.peak_frontier
+        << ",\"bytes_allocated\":" << stats.bytes_allocated
+        << ",\"index_ms\":" << stats.index_ms
+        << ",\"queue_ms\":" << stats.queue_ms;
+#endif
+    out << "}" << endl;
+}
+
 // Verify word ladder
 void verify_word_ladder() {
     set<string> word_list;
@@ -6,13 +6,94 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
+#include "dawg.h"
+#include "live_dictionary.h"
 
 using namespace std;
 
+// Work done by one generate_word_ladder call, filled in when requested.
+// The detailed counters cost time on every step and are only compiled in
+// when LADDER_PROFILE is defined (cmake -DLADDER_PROFILE=ON).
+struct LadderStats {
+    size_t nodes_expanded = 0;
+#ifdef LADDER_PROFILE
+    size_t nodes_dequeued = 0;
+    size_t candidates_tested = 0;   // neighbors offered to the visited check
+    size_t adjacency_checks = 0;    // is_adjacent calls
+    size_t neighbor_hits = 0;       // candidates seen for the first time
+    size_t peak_frontier = 0;
+    size_t bytes_allocated = 0;     // by the search's visited map and frontier
+    double index_ms = 0;            // producing neighbors
+    double queue_ms = 0;            // frontier pushes and pops
+#endif
+};
+
+// Every minimum-length ladder between two words, enumerated lazily. One
+// layered BFS builds a compact DAG of shortest-path predecessors over Dawg
+// word numbers; the iterator then walks it with O(ladder length) state, so
+// pairs with combinatorially many ladders stream at constant memory.
+// The Dawg must outlive this object.
+class ShortestLadders {
+public:
+    class iterator {
+    public:
+        using iterator_category = input_iterator_tag;
+        using value_type = vector<string>;
+        using difference_type = ptrdiff_t;
+        using pointer = const vector<string>*;
+        using reference = const vector<string>&;
+
+        iterator() = default;
+        reference operator*() const { return ladder; }
+        pointer operator->() const { return &ladder; }
+        iterator& operator++();
+        void operator++(int) { ++*this; }
+        bool operator==(const iterator& other) const { return path == other.path; }
+
+    private:
+        friend class ShortestLadders;
+        explicit iterator(const ShortestLadders* owner);
+
+        const ShortestLadders* owner = nullptr;
+        vector<uint32_t> path;    // DAG nodes from the goal back to the start; empty at end
+        vector<uint32_t> choice;  // which predecessor of path[i] was taken as path[i + 1]
+        vector<string> ladder;
+
+        void descend(size_t from);
+    };
+
+    ShortestLadders() = default;
+    ShortestLadders(const string& begin_word, const string& end_word, const Dawg& dictionary);
+
+    iterator begin() const { return word.empty() ? end() : iterator(this); }
+    iterator end() const { return iterator(); }
+    size_t length() const { return ladder_length; }   // words per ladder, 0 if none
+    uint64_t count() const;                            // number of ladders, saturating
+
+private:
+    const Dawg* dictionary = nullptr;
+    string start;                  // may be absent from the dictionary
+    uint32_t start_id = 0;
+    size_t ladder_length = 0;
+    vector<uint32_t> word;         // DAG node -> word number; node 0 is the goal
+    vector<uint32_t> first_pred;   // predecessors of node i are preds[first_pred[i] .. first_pred[i+1])
+    vector<uint32_t> preds;
+
+    size_t pred_count(uint32_t node) const { return first_pred[node + 1] - first_pred[node]; }
+    string word_of_id(uint32_t id) const;
+};
+
 void error(string word1, string word2, string msg);
 bool edit_distance_within(const std::string& str1, const std::string& str2, int d);
 bool is_adjacent(const string& word1, const string& word2);
-vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const set<string>& word_list);
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const set<string>& word_list, LadderStats* stats = nullptr);
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const Dawg& dictionary, LadderStats* stats = nullptr);
+vector<string> generate_word_ladder(const string& begin_word, const string& end_word, const LiveDictionary::Snapshot& dictionary, LadderStats* stats = nullptr);
+ShortestLadders all_shortest_ladders(const string& begin_word, const string& end_word, const Dawg& dictionary);
 void load_words(set<string> & word_list, const string& file_name);
 void print_word_ladder(const vector<string>& ladder);
+void print_ladder_stats_json(ostream& out, const string& begin_word, const string& end_word,
+                             const vector<string>& ladder, const LadderStats& stats);
 void verify_word_ladder();
@@ -0,0 +1,213 @@
+#include "ladder.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <malloc.h>
+#include <random>
+#include <sys/resource.h>
+#include <unordered_map>
+
+// Word-ladder benchmark: times dictionary loading, index builds and ladder
+// queries on generated workloads, so that optimizations can be compared.
+//
+//   ladder_bench [words_file] [--queries N] [--seed S] [--with-set]
+//
+// Built without sanitizers; the set<string> search scans the whole
+// dictionary for every expanded word and only runs with --with-set.
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Query {
+    string begin_word;
+    string end_word;
+};
+
+struct Workload {
+    string name;
+    vector<Query> queries;
+};
+
+double elapsed_ms(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Peak resident set size of the process so far
+double peak_rss_mb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+// Bytes currently allocated on the heap, for the footprint of one structure
+double heap_mb() {
+    return mallinfo2().uordblks / (1024.0 * 1024.0);
+}
+
+double percentile(vector<double> samples, double p) {
+    if (samples.empty())
+        return 0;
+    sort(samples.begin(), samples.end());
+    size_t rank = min(samples.size() - 1, size_t(p * samples.size()));
+    return samples[rank];
+}
+
+// Ladder distance (in words) from `start` to every word it can reach
+unordered_map<string, int> ladder_distances(const Dawg& dawg, const string& start) {
+    unordered_map<string, int> distance = {{start, 1}};
+    vector<string> layer = {start};
+    for (int d = 2; !layer.empty(); ++d) {
+        vector<string> next;
+        for (const string& word : layer) {
+            for (const string& neighbor : dawg.neighbors(word)) {
+                if (distance.emplace(neighbor, d).second)
+                    next.push_back(neighbor);
+            }
+        }
+        layer = move(next);
+    }
+    return distance;
+}
+
+// A start word whose component has fewer words than this is rejected by
+// the search almost at once, which would make unreachable pairs trivial
+constexpr size_t LARGE_COMPONENT = 1000;
+
+// Short pairs are 2-3 steps apart, long pairs at least 6, and unreachable
+// pairs start in a large component and end outside it
+vector<Workload> make_workloads(const set<string>& word_list, const Dawg& dawg, size_t count, unsigned seed) {
+    vector<string> words(word_list.begin(), word_list.end());
+    mt19937 rng(seed);
+    auto pick = [&](const vector<string>& from) { return from[rng() % from.size()]; };
+
+    Workload short_pairs{"short", {}}, long_pairs{"long", {}}, unreachable{"unreachable", {}};
+    for (size_t attempt = 0; attempt < 50 * count; ++attempt) {
+        bool need_short = short_pairs.queries.size() < count;
+        bool need_long = long_pairs.queries.size() < count;
+        bool need_unreachable = unreachable.queries.size() < count;
+        if (!need_short && !need_long && !need_unreachable)
+            break;
+
+        string start = pick(words);
+        unordered_map<string, int> distance = ladder_distances(dawg, start);
+        vector<string> near, far;
+        for (const auto& [word, d] : distance) {
+            if (d >= 3 && d <= 4)
+                near.push_back(word);
+            else if (d >= 7)
+                far.push_back(word);
+        }
+        sort(near.begin(), near.end());
+        sort(far.begin(), far.end());
+
+        if (need_short && !near.empty())
+            short_pairs.queries.push_back({start, pick(near)});
+        if (need_long && !far.empty())
+            long_pairs.queries.push_back({start, pick(far)});
+        if (need_unreachable && distance.size() >= LARGE_COMPONENT) {
+            string end_word = pick(words);
+            if (!distance.count(end_word))
+                unreachable.queries.push_back({start, end_word});
+        }
+    }
+    return {short_pairs, long_pairs, unreachable};
+}
+
+using LadderSearch = function<vector<string>(const Query&, LadderStats*)>;
+
+void run_workload(const string& backend, const Workload& workload, const LadderSearch& search) {
+    vector<double> latency;
+    size_t nodes = 0, found = 0;
+    for (const Query& query : workload.queries) {
+        LadderStats stats;
+        auto start = Clock::now();
+        vector<string> ladder = search(query, &stats);
+        latency.push_back(elapsed_ms(start));
+        nodes += stats.nodes_expanded;
+        found += !ladder.empty();
+    }
+    size_t n = max<size_t>(1, workload.queries.size());
+    cout << left << setw(8) << backend << setw(13) << workload.name << right
+         << setw(8) << workload.queries.size() << setw(8) << found
+         << fixed << setprecision(3) << setw(12) << percentile(latency, 0.50)
+         << setw(12) << percentile(latency, 0.99)
+         << setw(12) << nodes / n << setprecision(1) << setw(12) << peak_rss_mb() << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    string file_name = "../src/words.txt";
+    size_t count = 50;
+    unsigned seed = 46;
+    bool with_set = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--queries" && i + 1 < argc)
+            count = stoul(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = stoul(argv[++i]);
+        else if (arg == "--with-set")
+            with_set = true;
+        else
+            file_name = arg;
+    }
+
+    set<string> word_list;
+    auto start = Clock::now();
+    load_words(word_list, file_name);
+    cout << "load_words          " << fixed << setprecision(1) << setw(10) << elapsed_ms(start)
+         << " ms  peak " << peak_rss_mb() << " MB  (" << word_list.size() << " words)" << endl;
+
+    double heap_before = heap_mb();
+    start = Clock::now();
+    Dawg dawg(word_list);
+    cout << "Dawg build          " << setw(10) << elapsed_ms(start) << " ms  peak " << peak_rss_mb()
+         << " MB  heap +" << heap_mb() - heap_before << " MB  (" << dawg.memory_bytes() / 1024 << " KB)" << endl;
+
+    start = Clock::now();
+    vector<Workload> workloads = make_workloads(word_list, dawg, count, seed);
+    cout << "workload generation " << setw(10) << elapsed_ms(start) << " ms" << endl << endl;
+
+    // Each backend is built right before its queries run, so the peak
+    // column shows what that backend added on top of the ones before it
+    auto print_header = [] {
+        cout << left << setw(8) << "backend" << setw(13) << "workload" << right << setw(8) << "queries"
+             << setw(8) << "found" << setw(12) << "p50 ms" << setw(12) << "p99 ms" << setw(12) << "nodes/q"
+             << setw(12) << "peak MB" << endl;
+    };
+    print_header();
+    for (const Workload& workload : workloads) {
+        run_workload("dawg", workload, [&](const Query& q, LadderStats* stats) {
+            return generate_word_ladder(q.begin_word, q.end_word, dawg, stats);
+        });
+    }
+
+    heap_before = heap_mb();
+    start = Clock::now();
+    LiveDictionary live(word_list);
+    shared_ptr<const LiveDictionary::Snapshot> snapshot = live.snapshot();
+    cout << endl << "LiveDictionary build" << setw(10) << elapsed_ms(start) << " ms  peak " << peak_rss_mb()
+         << " MB  heap +" << heap_mb() - heap_before << " MB" << endl;
+    print_header();
+    for (const Workload& workload : workloads) {
+        run_workload("live", workload, [&](const Query& q, LadderStats* stats) {
+            return generate_word_ladder(q.begin_word, q.end_word, *snapshot, stats);
+        });
+    }
+
+    if (with_set) {
+        cout << endl;
+        print_header();
+        for (const Workload& workload : workloads) {
+            run_workload("set", workload, [&](const Query& q, LadderStats* stats) {
+                return generate_word_ladder(q.begin_word, q.end_word, word_list, stats);
+            });
+        }
+    }
+    return 0;
+}
@@ -1,10 +1,41 @@
 #include "ladder.h"
+#include <memory>
 
-int main() {
+int main(int argc, char* argv[]) {
     // Load dictionary words
     set<string> word_list;
     load_words(word_list, "../src/words.txt");
 
+    // Compare the Dawg against the standard containers and exit
+    if (argc > 1 && string(argv[1]) == "--dict-stats") {
+        report_dictionary_stats(word_list, Dawg(word_list));
+        return 0;
+    }
+
+    // Batch mode: read "start end" pairs from stdin until EOF and print one
+    // JSON line of search counters per query
+    if (argc > 1 && string(argv[1]) == "--profile") {
+        string backend = argc > 2 ? argv[2] : "dawg";
+        Dawg dawg(word_list);
+        unique_ptr<LiveDictionary> live = backend == "live" ? make_unique<LiveDictionary>(word_list) : nullptr;
+#ifndef LADDER_PROFILE
+        cerr << "Only node counts are available; rebuild with -DLADDER_PROFILE=ON for the full profile." << endl;
+#endif
+        string begin_word, end_word;
+        while (cin >> begin_word >> end_word) {
+            LadderStats stats;
+            vector<string> ladder;
+            if (backend == "set")
+                ladder = generate_word_ladder(begin_word, end_word, word_list, &stats);
+            else if (backend == "live")
+                ladder = generate_word_ladder(begin_word, end_word, *live->snapshot(), &stats);
+            else
+                ladder = generate_word_ladder(begin_word, end_word, dawg, &stats);
+            print_ladder_stats_json(cout, begin_word, end_word, ladder, stats);
+        }
+        return 0;
+    }
+
     // Prompt user for start and end words
     string start_word, end_word;
     
@@ -0,0 +1,170 @@
+#include "live_dictionary.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+using WordRef = shared_ptr<const string>;
+using WordIndex = PersistentMap<string, vector<WordRef>>;
+
+// Words are stored lowercase, as load_words and the ladder queries use them
+string lowercase(string word) {
+    transform(word.begin(), word.end(), word.begin(), ::tolower);
+    return word;
+}
+
+bool spelled_before(const WordRef& a, const WordRef& b) {
+    return *a < *b;
+}
+
+// Substitution key: the word with letter i blanked out. Two words of equal
+// length are one substitution apart exactly when they share such a key.
+string blanked(const string& word, size_t i) {
+    string key = word;
+    key[i] = '\0';
+    return key;
+}
+
+// The word with letter i removed
+string deleted(const string& word, size_t i) {
+    return word.substr(0, i) + word.substr(i + 1);
+}
+
+// The word with a blank inserted before letter i. This is the substitution
+// key of every word one insertion away, so no separate index is needed.
+string widened(const string& word, size_t i) {
+    return word.substr(0, i) + '\0' + word.substr(i);
+}
+
+// Removing either letter of a doubled pair gives the same word; only the
+// first position of each run is tried
+bool starts_run(const string& word, size_t i) {
+    return i == 0 || word[i] != word[i - 1];
+}
+
+// Buckets are small, so copying one for the new version costs a few
+// pointer copies rather than string copies
+void index_add(WordIndex& index, const string& key, const WordRef& word) {
+    const vector<WordRef>* found = index.find(key);
+    vector<WordRef> words = found ? *found : vector<WordRef>();
+    words.insert(lower_bound(words.begin(), words.end(), word, spelled_before), word);
+    index = index.insert(key, move(words));
+}
+
+void index_remove(WordIndex& index, const string& key, const string& word) {
+    const vector<WordRef>* found = index.find(key);
+    if (!found)
+        return;
+    vector<WordRef> words = *found;
+    words.erase(remove_if(words.begin(), words.end(), [&](const WordRef& w) { return *w == word; }), words.end());
+    index = words.empty() ? index.erase(key) : index.insert(key, move(words));
+}
+
+// Group (key, word) pairs into word lists by sorting them once; the pairs
+// arrive in word order and the stable sort keeps each list sorted
+WordIndex build_index(vector<pair<string, WordRef>> keyed) {
+    stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    vector<pair<string, vector<WordRef>>> grouped;
+    for (auto& [key, word] : keyed) {
+        if (grouped.empty() || grouped.back().first != key)
+            grouped.emplace_back(move(key), vector<WordRef>());
+        grouped.back().second.push_back(move(word));
+    }
+    return WordIndex(move(grouped));
+}
+
+} // namespace
+
+vector<string> LiveDictionary::Snapshot::neighbors(const string& word) const {
+    vector<string> out;
+    for (size_t i = 0; i < word.size(); ++i) {
+        if (const vector<WordRef>* same_length = by_pattern.find(blanked(word, i))) {
+            for (const WordRef& candidate : *same_length) {
+                if (*candidate != word)
+                    out.push_back(*candidate);
+            }
+        }
+        if (starts_run(word, i)) {
+            string shorter = deleted(word, i);
+            if (contains(shorter))
+                out.push_back(shorter);
+        }
+    }
+    for (size_t i = 0; i <= word.size(); ++i) {
+        if (const vector<WordRef>* longer = by_pattern.find(widened(word, i))) {
+            for (const WordRef& candidate : *longer)
+                out.push_back(*candidate);
+        }
+    }
+
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+LiveDictionary::LiveDictionary() : current(make_shared<const Snapshot>()) {}
+
+// The initial load collects every (key, word) pair and bulk-builds each map
+// once instead of path copying per word
+LiveDictionary::LiveDictionary(const set<string>& word_list) {
+    // Lowercasing can reorder the list and merge spellings, so it comes first
+    set<string> lowered;
+    for (const string& word : word_list)
+        lowered.insert(lowercase(word));
+
+    vector<pair<WordRef, bool>> words;
+    vector<pair<string, WordRef>> patterns;
+    for (const string& word : lowered) {
+        WordRef ref = make_shared<const string>(word);
+        words.emplace_back(ref, true);
+        for (size_t i = 0; i < word.size(); ++i)
+            patterns.emplace_back(blanked(word, i), ref);
+    }
+
+    Snapshot first;
+    first.words = decltype(first.words)(move(words));
+    first.by_pattern = build_index(move(patterns));
+    current.store(make_shared<const Snapshot>(move(first)));
+}
+
+void LiveDictionary::add(Snapshot& next, const string& word) {
+    WordRef ref = make_shared<const string>(word);
+    next.words = next.words.insert(ref, true);
+    for (size_t i = 0; i < word.size(); ++i)
+        index_add(next.by_pattern, blanked(word, i), ref);
+}
+
+void LiveDictionary::remove(Snapshot& next, const string& word) {
+    next.words = next.words.erase(word);
+    for (size_t i = 0; i < word.size(); ++i)
+        index_remove(next.by_pattern, blanked(word, i), word);
+}
+
+bool LiveDictionary::insert(const string& spelling) {
+    string word = lowercase(spelling);
+    lock_guard<mutex> lock(writer);
+    shared_ptr<const Snapshot> base = current.load();
+    if (base->contains(word))
+        return false;
+
+    Snapshot next = *base;
+    add(next, word);
+    ++next.generation;
+    current.store(make_shared<const Snapshot>(move(next)));
+    return true;
+}
+
+bool LiveDictionary::erase(const string& spelling) {
+    string word = lowercase(spelling);
+    lock_guard<mutex> lock(writer);
+    shared_ptr<const Snapshot> base = current.load();
+    if (!base->contains(word))
+        return false;
+
+    Snapshot next = *base;
+    remove(next, word);
+    ++next.generation;
+    current.store(make_shared<const Snapshot>(move(next)));
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "persistent_map.h"
+
+using namespace std;
+
+// Dictionary and one-edit neighbor index that can be updated while ladder
+// queries run. Readers take an immutable Snapshot with a single atomic load
+// and never wait for a writer; writers build the next version by path
+// copying, touching O(L) index entries for a word of length L, and publish
+// it atomically. An old Snapshot is freed when its last reader drops it.
+class LiveDictionary {
+public:
+    class Snapshot {
+    public:
+        bool contains(const string& word) const { return words.find(word) != nullptr; }
+        size_t size() const { return words.size(); }
+        uint64_t version() const { return generation; }
+
+        // Every word one substitution, insertion or deletion away from `word`
+        vector<string> neighbors(const string& word) const;
+
+    private:
+        friend class LiveDictionary;
+
+        // Each word is allocated once; the word set and every bucket it is
+        // in share that copy
+        using WordRef = shared_ptr<const string>;
+
+        // Hash and compare by spelling, so a plain string finds its WordRef
+        struct SpellingHash {
+            size_t operator()(const string& word) const { return hash<string>()(word); }
+            size_t operator()(const WordRef& word) const { return hash<string>()(*word); }
+        };
+        struct SameSpelling {
+            bool operator()(const WordRef& a, const string& b) const { return *a == b; }
+            bool operator()(const WordRef& a, const WordRef& b) const { return *a == *b; }
+        };
+
+        PersistentMap<WordRef, bool, SpellingHash, SameSpelling> words;
+        PersistentMap<string, vector<WordRef>> by_pattern;  // word with one letter blanked out
+        uint64_t generation = 0;
+    };
+
+    LiveDictionary();
+    explicit LiveDictionary(const set<string>& word_list);
+
+    // Current version of the dictionary; stays valid and unchanged for as
+    // long as the caller holds it
+    shared_ptr<const Snapshot> snapshot() const { return current.load(); }
+
+    // Add or remove one word and publish a new version; false if nothing
+    // changed. Words are lowercased first, as load_words does.
+    bool insert(const string& word);
+    bool erase(const string& word);
+
+private:
+    mutex writer;
+    atomic<shared_ptr<const Snapshot>> current;
+
+    static void add(Snapshot& next, const string& word);
+    static void remove(Snapshot& next, const string& word);
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Immutable hash map (a hash array mapped trie). insert and erase leave the
+// map untouched and return a new version that shares every node off the
+// changed path, so an update costs O(log32 n) node copies and old versions
+// stay valid for as long as someone holds them.
+//
+// `Hash` and `Equal` may accept other types than Key (as a transparent
+// hash would), and find and erase then take those types directly.
+template <typename Key, typename Value, typename Hash = hash<Key>, typename Equal = equal_to<>>
+class PersistentMap {
+public:
+    PersistentMap() = default;
+
+    // Bulk build from distinct keys in one pass, without the per-insert copies
+    explicit PersistentMap(vector<pair<Key, Value>> entries) : count(entries.size()) {
+        // Sort small (order, index) pairs rather than the entries themselves
+        vector<pair<uint64_t, size_t>> order;
+        order.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i)
+            order.emplace_back(route_order(Hash{}(entries[i].first)), i);
+        sort(order.begin(), order.end());
+
+        vector<pair<size_t, pair<Key, Value>>> hashed;
+        hashed.reserve(entries.size());
+        for (const auto& [route, i] : order)
+            hashed.emplace_back(Hash{}(entries[i].first), move(entries[i]));
+        root = build(hashed.begin(), hashed.end(), 0);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    template <typename K>
+    const Value* find(const K& key) const {
+        size_t h = Hash{}(key);
+        const Node* node = root.get();
+        for (unsigned shift = 0; node && !node->is_leaf; shift += BITS) {
+            const Branch* branch = static_cast<const Branch*>(node);
+            uint32_t bit = 1u << ((h >> shift) & MASK);
+            if (!(branch->bitmap & bit))
+                return nullptr;
+            node = branch->children[popcount(branch->bitmap & (bit - 1))].get();
+        }
+        for (const Leaf* leaf = static_cast<const Leaf*>(node); leaf; leaf = leaf->next.get()) {
+            if (leaf->hash == h && Equal{}(leaf->entry.first, key))
+                return &leaf->entry.second;
+        }
+        return nullptr;
+    }
+
+    PersistentMap insert(const Key& key, Value value) const {
+        bool added = false;
+        PersistentMap next;
+        next.root = insert(root, 0, Hash{}(key), key, move(value), added);
+        next.count = count + added;
+        return next;
+    }
+
+    template <typename K>
+    PersistentMap erase(const K& key) const {
+        bool removed = false;
+        PersistentMap next;
+        next.root = erase(root, 0, Hash{}(key), key, removed);
+        next.count = count - removed;
+        return next;
+    }
+
+private:
+    static constexpr unsigned BITS = 5;
+    static constexpr size_t MASK = (1u << BITS) - 1;
+
+    // A branch routes on the next five hash bits; a leaf holds one entry
+    // inline, chained to the other entries with the same full hash (rare)
+    struct Node {
+        explicit Node(bool is_leaf) : is_leaf(is_leaf) {}
+        bool is_leaf;
+    };
+    using NodePtr = shared_ptr<const Node>;
+
+    struct Leaf : Node {
+        Leaf(size_t hash, pair<Key, Value> entry, shared_ptr<const Leaf> next)
+            : Node(true), hash(hash), entry(move(entry)), next(move(next)) {}
+        size_t hash;
+        pair<Key, Value> entry;
+        shared_ptr<const Leaf> next;
+    };
+
+    struct Branch : Node {
+        Branch() : Node(false) {}
+        uint32_t bitmap = 0;
+        vector<NodePtr> children;
+    };
+
+    NodePtr root;
+    size_t count = 0;
+
+    static const Leaf* as_leaf(const NodePtr& node) { return static_cast<const Leaf*>(node.get()); }
+    static const Branch* as_branch(const NodePtr& node) { return static_cast<const Branch*>(node.get()); }
+
+    // Leaves for entries sharing hash `h`, in order; null when there are none
+    static shared_ptr<const Leaf> make_chain(size_t h, vector<pair<Key, Value>>& entries) {
+        shared_ptr<const Leaf> chain;
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+            chain = make_shared<Leaf>(h, move(*it), move(chain));
+        return chain;
+    }
+
+    static vector<pair<Key, Value>> chain_entries(const NodePtr& node) {
+        vector<pair<Key, Value>> entries;
+        for (const Leaf* leaf = as_leaf(node); leaf; leaf = leaf->next.get())
+            entries.push_back(leaf->entry);
+        return entries;
+    }
+
+    using HashedIter = typename vector<pair<size_t, pair<Key, Value>>>::iterator;
+
+    // The hash rearranged so that its first routing digit is the most
+    // significant; sorting by it lays every subtree out as a contiguous run
+    // with its children in bitmap order
+    static uint64_t route_order(uint64_t h) {
+        uint64_t order = 0;
+        for (unsigned shift = 0; shift + BITS <= 64; shift += BITS)
+            order = (order << BITS) | ((h >> shift) & MASK);
+        return (order << 4) | (h >> 60);
+    }
+
+    // Entries in [first, last) agree on the hash bits below `shift`
+    static NodePtr build(HashedIter first, HashedIter last, unsigned shift) {
+        if (first == last)
+            return nullptr;
+        size_t h = first->first;
+        if (all_of(first, last, [&](const auto& e) { return e.first == h; })) {
+            vector<pair<Key, Value>> entries;
+            for (auto it = first; it != last; ++it)
+                entries.push_back(move(it->second));
+            return make_chain(h, entries);
+        }
+
+        auto slot = [shift](const auto& e) { return (e.first >> shift) & MASK; };
+        auto branch = make_shared<Branch>();
+        while (first != last) {
+            auto group_end = find_if(first, last, [&](const auto& e) { return slot(e) != slot(*first); });
+            branch->bitmap |= 1u << slot(*first);
+            branch->children.push_back(build(first, group_end, shift + BITS));
+            first = group_end;
+        }
+        return branch;
+    }
+
+    static NodePtr insert(const NodePtr& node, unsigned shift, size_t h, const Key& key, Value&& value,
+                          bool& added) {
+        if (!node) {
+            added = true;
+            return make_shared<Leaf>(h, pair<Key, Value>(key, move(value)), nullptr);
+        }
+        if (node->is_leaf) {
+            if (as_leaf(node)->hash == h) {
+                vector<pair<Key, Value>> entries = chain_entries(node);
+                auto it = find_if(entries.begin(), entries.end(), [&](const auto& e) { return Equal{}(e.first, key); });
+                if (it != entries.end()) {
+                    it->second = move(value);
+                } else {
+                    entries.emplace_back(key, move(value));
+                    added = true;
+                }
+                return make_chain(h, entries);
+            }
+            // Different hash: push the existing leaf one level down and retry
+            auto branch = make_shared<Branch>();
+            branch->bitmap = 1u << ((as_leaf(node)->hash >> shift) & MASK);
+            branch->children.push_back(node);
+            return insert(branch, shift, h, key, move(value), added);
+        }
+
+        uint32_t bit = 1u << ((h >> shift) & MASK);
+        size_t pos = popcount(as_branch(node)->bitmap & (bit - 1));
+        auto branch = make_shared<Branch>(*as_branch(node));
+        if (branch->bitmap & bit) {
+            branch->children[pos] = insert(branch->children[pos], shift + BITS, h, key, move(value), added);
+        } else {
+            branch->bitmap |= bit;
+            branch->children.insert(branch->children.begin() + pos,
+                                    make_shared<Leaf>(h, pair<Key, Value>(key, move(value)), nullptr));
+            added = true;
+        }
+        return branch;
+    }
+
+    template <typename K>
+    static NodePtr erase(const NodePtr& node, unsigned shift, size_t h, const K& key, bool& removed) {
+        if (!node)
+            return node;
+        if (node->is_leaf) {
+            if (as_leaf(node)->hash != h)
+                return node;
+            vector<pair<Key, Value>> entries = chain_entries(node);
+            auto it = find_if(entries.begin(), entries.end(), [&](const auto& e) { return Equal{}(e.first, key); });
+            if (it == entries.end())
+                return node;
+            removed = true;
+            entries.erase(it);
+            return make_chain(h, entries);
+        }
+
+        const Branch* old = as_branch(node);
+        uint32_t bit = 1u << ((h >> shift) & MASK);
+        if (!(old->bitmap & bit))
+            return node;
+        size_t pos = popcount(old->bitmap & (bit - 1));
+        NodePtr child = erase(old->children[pos], shift + BITS, h, key, removed);
+        if (child == old->children[pos])
+            return node;
+
+        auto branch = make_shared<Branch>(*old);
+        if (child) {
+            branch->children[pos] = move(child);
+        } else {
+            branch->bitmap &= ~bit;
+            branch->children.erase(branch->children.begin() + pos);
+        }
+        // A branch left holding a single leaf collapses back into that leaf
+        if (branch->children.empty())
+            return nullptr;
+        if (branch->children.size() == 1 && branch->children[0]->is_leaf)
+            return branch->children[0];
+        return branch;
+    }
+};